@@ -0,0 +1,95 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Cost of the `compact` data enum layout against the default one.
+#   scripts/bench_enums.sh <drast> [rounds]
+# Builds, walks and drops balanced trees and long right-leaning lists, once with
+# `enum Tree compact` (tagged union, recursive fields in a region) and once with plain
+# `enum Tree` (std::variant, one std::unique_ptr per recursive field), then prints each
+# binary's wall time. Both must print the same result.
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/.." && pwd)"
+
+compiler="${1:?usage: bench_enums.sh <drast> [rounds]}"
+rounds="${2:-20}"
+if [[ "$compiler" != /* ]]; then
+    compiler="$PWD/$compiler"
+fi
+
+work_dir="$(mktemp -d)"
+trap 'chmod -R u+w "$work_dir" 2>/dev/null || true; rm -rf "$work_dir"' EXIT
+
+cat >"$work_dir/compact.drast" <<SRC
+use drast
+
+enum Tree compact
+	Leaf value;int
+	Node left;Tree right;Tree
+
+grow depth;int seed;int, Tree
+	if depth == 0
+		value = seed % 7
+		return Tree.Leaf[value]
+	return Tree.Node[[grow [depth - 1] [seed * 2]] [grow [depth - 1] [seed * 2 + 1]]]
+
+growList length;int, Tree
+	if length == 0
+		return Tree.Leaf[0]
+	return Tree.Node[Tree.Leaf[1] [growList [length - 1]]]
+
+sumTree tree;~Tree, int
+	match tree
+		Tree.Leaf value
+			return value
+		Tree.Node left right
+			return [sumTree left] + [sumTree right]
+
+main, int
+	total = 0
+	for round in 0 until $rounds
+		tree = grow 16 1
+		total += sumTree tree
+		for i in 0 until 64
+			list = growList 1000
+			total += sumTree list
+	println toString total
+	return 0
+SRC
+sed 's/^enum Tree compact$/enum Tree/' "$work_dir/compact.drast" >"$work_dir/boxed.drast"
+cat >"$work_dir/package.txt" <<PKG
+package enumbench
+version 0.0.0
+default compact
+
+target compact
+	kind binary
+	entry compact.drast
+	output bin/bench-compact
+	include $repo_root
+	cxx c++17
+
+target boxed
+	kind binary
+	entry boxed.drast
+	output bin/bench-boxed
+	include $repo_root
+	cxx c++17
+PKG
+
+bench_one() {
+    local target="$1"
+    local binary start end elapsed_ns result
+    (cd "$work_dir" && DRAST_HOME="$repo_root" "$compiler" build "$target" >/dev/null)
+    binary="$(find "$work_dir/build" -type f -name "bench-$target" -perm -u+x | head -n 1)"
+    start=$(date +%s%N)
+    result="$("$binary" | tr '\n' ' ')"
+    end=$(date +%s%N)
+    elapsed_ns=$((end - start))
+    awk -v label="$target" -v ns="$elapsed_ns" -v result="$result" 'BEGIN {
+        printf "%-8s %.3fs  result=%s\n", label, ns / 1e9, result
+    }'
+}
+
+bench_one compact
+bench_one boxed
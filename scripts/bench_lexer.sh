@@ -0,0 +1,41 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Lexer throughput over the compiler's own sources.
+#   scripts/bench_lexer.sh <drast> [baseline-drast] [rounds]
+# Prints the wall time, MB/s, and peak RSS of `drast lex-bench src <rounds>` for each
+# binary, so a lexer change can be compared against another build that has `lex-bench`.
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/.." && pwd)"
+
+compiler="${1:?usage: bench_lexer.sh <drast> [baseline-drast] [rounds]}"
+baseline="${2:-}"
+rounds="${3:-20}"
+
+bench_one() {
+    local label="$1" binary="$2"
+    local start end summary bytes elapsed_ns rss=""
+    "$binary" lex-bench src 1 >/dev/null
+    start=$(date +%s%N)
+    summary="$(cd "$repo_root" && "$binary" lex-bench src "$rounds")"
+    end=$(date +%s%N)
+    elapsed_ns=$((end - start))
+    bytes="$(sed -n 's/.* bytes=\([0-9]*\).*/\1/p' <<<"$summary")"
+    if [[ -x /usr/bin/time ]]; then
+        rss="$(cd "$repo_root" && /usr/bin/time -f '%M' "$binary" lex-bench src 1 2>&1 >/dev/null | tail -n 1)"
+    fi
+    awk -v label="$label" -v ns="$elapsed_ns" -v bytes="$bytes" -v rounds="$rounds" -v rss="$rss" -v summary="$summary" 'BEGIN {
+        seconds = ns / 1e9
+        mbps = (bytes * rounds) / (1024 * 1024) / seconds
+        printf "%-9s %s\n          %.3fs  %.1f MB/s", label, summary, seconds, mbps
+        if (rss != "") printf "  peak %d KiB", rss
+        printf "\n"
+    }'
+}
+
+cd "$repo_root"
+bench_one "current" "$compiler"
+if [[ -n "$baseline" ]]; then
+    bench_one "baseline" "$baseline"
+fi
@@ -0,0 +1,84 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Cost of the default `map` layout against the node-based one.
+#   scripts/bench_maps.sh <drast> [rounds]
+# Builds one word-count and integer-index program twice, once with `map` (the flat
+# open-addressing table) and once with every `map` spelled `node_map` (std::unordered_map),
+# then prints each binary's wall time. Both must print the same result.
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/.." && pwd)"
+
+compiler="${1:?usage: bench_maps.sh <drast> [rounds]}"
+rounds="${2:-20}"
+if [[ "$compiler" != /* ]]; then
+    compiler="$PWD/$compiler"
+fi
+
+work_dir="$(mktemp -d)"
+trap 'chmod -R u+w "$work_dir" 2>/dev/null || true; rm -rf "$work_dir"' EXIT
+
+cat >"$work_dir/flat.drast" <<SRC
+use drast
+
+main, int
+	keys {string};
+	for i in 0 until 200000
+		keys += 'k' + toString [i * 7919 % 1000003]
+	counts map\`[string int];
+	ids map\`[int int];
+	for round in 0 until $rounds
+		for key in keys
+			if counts.contains key
+				current = counts.get key 0
+				counts.set key current + 1
+			else
+				counts.set key 1
+		for i in 0 until 200000
+			slot = i * 7919 % 1000003
+			ids.set slot [ids.get slot 0] + 1
+	total = 0
+	for key in keys
+		total += counts.get key 0
+	println toString total
+	println toString ids.length
+	return 0
+SRC
+sed 's/map`\[/node_map`[/g' "$work_dir/flat.drast" >"$work_dir/node.drast"
+cat >"$work_dir/package.txt" <<PKG
+package mapbench
+version 0.0.0
+default flat
+
+target flat
+	kind binary
+	entry flat.drast
+	output bin/bench-flat
+	include $repo_root
+	cxx c++17
+
+target node
+	kind binary
+	entry node.drast
+	output bin/bench-node
+	include $repo_root
+	cxx c++17
+PKG
+
+bench_one() {
+    local target="$1"
+    local binary start end elapsed_ns result
+    (cd "$work_dir" && DRAST_HOME="$repo_root" "$compiler" build "$target" >/dev/null)
+    binary="$(find "$work_dir/build" -type f -name "bench-$target" -perm -u+x | head -n 1)"
+    start=$(date +%s%N)
+    result="$("$binary" | tr '\n' ' ')"
+    end=$(date +%s%N)
+    elapsed_ns=$((end - start))
+    awk -v label="$target" -v ns="$elapsed_ns" -v result="$result" 'BEGIN {
+        printf "%-6s %.3fs  result=%s\n", label, ns / 1e9, result
+    }'
+}
+
+bench_one flat
+bench_one node
@@ -0,0 +1,76 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Cost of checked integer arithmetic on a hot loop.
+#   scripts/bench_overflow.sh <drast> [rounds]
+# Builds one program twice, as an `overflow wrap` target and an `overflow checked` target,
+# then prints each binary's wall time and how many `_checked(` calls range analysis left
+# in the generated C++, so a lowering change can be judged by both numbers.
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/.." && pwd)"
+
+compiler="${1:?usage: bench_overflow.sh <drast> [rounds]}"
+rounds="${2:-200}"
+if [[ "$compiler" != /* ]]; then
+    compiler="$PWD/$compiler"
+fi
+
+work_dir="$(mktemp -d)"
+trap 'chmod -R u+w "$work_dir" 2>/dev/null || true; rm -rf "$work_dir"' EXIT
+
+# `i & 1023`, `i * 2`, and the `% 1000003` divisor are provably in range; the running total
+# and the loaded element are not, so their `+` and `*` keep a check.
+cat >"$work_dir/main.drast" <<SRC
+use drast
+
+main, int
+	values {int};
+	for i in 0 until 1000000
+		values += i & 1023
+	total = 0
+	for round in 0 until $rounds
+		for i in 0 until 1000000
+			total = [total + values{i} * 3 + i * 2] % 1000003
+	println toString total
+	return 0
+SRC
+cat >"$work_dir/package.txt" <<PKG
+package overflowbench
+version 0.0.0
+default wrap
+
+target wrap
+	kind binary
+	entry main.drast
+	output bin/bench-wrap
+	include $repo_root
+	cxx c++17
+	overflow wrap
+
+target checked
+	kind binary
+	entry main.drast
+	output bin/bench-checked
+	include $repo_root
+	cxx c++17
+	overflow checked
+PKG
+
+bench_one() {
+    local target="$1"
+    local binary start end elapsed_ns checks result
+    (cd "$work_dir" && DRAST_HOME="$repo_root" "$compiler" build "$target" >/dev/null)
+    binary="$(find "$work_dir/build" -type f -name "bench-$target" -perm -u+x | head -n 1)"
+    checks="$(cat "$work_dir/build/generated/$target"/main.* | grep -o '_checked(' | wc -l | tr -d ' ')"
+    start=$(date +%s%N)
+    result="$("$binary")"
+    end=$(date +%s%N)
+    elapsed_ns=$((end - start))
+    awk -v label="$target" -v ns="$elapsed_ns" -v checks="$checks" -v result="$result" 'BEGIN {
+        printf "%-8s %.3fs  checks=%d  result=%s\n", label, ns / 1e9, checks, result
+    }'
+}
+
+bench_one wrap
+bench_one checked
@@ -0,0 +1,58 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Build time against module count.
+#   scripts/bench_wide.sh <drast> [sizes] [tolerance]
+# Generates one package per size in `sizes` (default "200 400 800") with
+# scripts/gen_wide_package.sh and builds each cold. With `unity on` the C++ side is one
+# translation unit, so the time is dominated by the compiler itself. Prints the build time
+# and time per module for each size, and fails when the per-module time of the largest size
+# exceeds the smallest one's by more than `tolerance` (default 1.5), i.e. when growth is not
+# linear. tests/run_tests.sh runs the same check with a looser bound.
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/.." && pwd)"
+
+compiler="${1:?usage: bench_wide.sh <drast> [sizes] [tolerance]}"
+sizes="${2:-200 400 800}"
+tolerance="${3:-1.5}"
+if [[ "$compiler" != /* ]]; then
+    compiler="$PWD/$compiler"
+fi
+
+work_dir="$(mktemp -d)"
+trap 'chmod -R u+w "$work_dir" 2>/dev/null || true; rm -rf "$work_dir"' EXIT
+
+first_count=""
+first_ns=""
+last_count=""
+last_ns=""
+for count in $sizes; do
+    dir="$work_dir/wide-$count"
+    "$script_dir/gen_wide_package.sh" "$dir" "$count"
+    start=$(date +%s%N)
+    (cd "$dir" && DRAST_HOME="$repo_root" "$compiler" build >/dev/null)
+    end=$(date +%s%N)
+    elapsed_ns=$((end - start))
+    binary="$(find "$dir/build" -type f -name wide -perm -u+x | head -n 1)"
+    result="$("$binary")"
+    if [[ "$result" != "$((count * (count - 1)))" ]]; then
+        echo "FAIL: $count modules printed [$result], expected $((count * (count - 1)))" >&2
+        exit 1
+    fi
+    if [[ -z "$first_count" ]]; then
+        first_count="$count"
+        first_ns="$elapsed_ns"
+    fi
+    last_count="$count"
+    last_ns="$elapsed_ns"
+    awk -v count="$count" -v ns="$elapsed_ns" -v base_count="$first_count" -v base_ns="$first_ns" 'BEGIN {
+        printf "%5d modules  %.3fs  %.2f ms/module  x%.2f time for x%.2f modules\n", count, ns / 1e9, ns / 1e6 / count, ns / base_ns, count / base_count
+    }'
+done
+
+awk -v a_count="$first_count" -v a_ns="$first_ns" -v b_count="$last_count" -v b_ns="$last_ns" -v tolerance="$tolerance" 'BEGIN {
+    growth = (b_ns / b_count) / (a_ns / a_count)
+    printf "per-module time grew x%.2f from %d to %d modules (limit x%.2f)\n", growth, a_count, b_count, tolerance
+    exit growth > tolerance ? 1 : 0
+}'
@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Writes a package of many near-identical modules, for build-scaling checks.
+#   scripts/gen_wide_package.sh <dir> <modules> [unity]
+# Each module holds a struct, a global, an impl, and a step function; `main` imports and
+# chains every step, so the binary prints modules * (modules - 1). `unity` is written into
+# the target as is (default `on`, which keeps the C++ side to one translation unit).
+
+script_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_root="$(cd "$script_dir/.." && pwd)"
+
+dir="${1:?usage: gen_wide_package.sh <dir> <modules> [unity]}"
+count="${2:?usage: gen_wide_package.sh <dir> <modules> [unity]}"
+unity="${3:-on}"
+
+mkdir -p "$dir/wide"
+{
+    printf 'use drast\n'
+    for ((i = 0; i < count; i++)); do
+        printf 'use wide/unit_%04d\n' "$i"
+    done
+    printf '\nmain, int\n\tacc = 0\n'
+    for ((i = 0; i < count; i++)); do
+        printf '\tacc = wideStep%04d acc\n' "$i"
+    done
+    printf '\tprintln acc\n\treturn 0\n'
+} >"$dir/main.drast"
+for ((i = 0; i < count; i++)); do
+    name="$(printf '%04d' "$i")"
+    cat >"$dir/wide/unit_$name.drast" <<SRC
+struct Wide$name
+	value int
+
+wideBase$name i32 = $i
+
+impl Wide$name
+	init
+		self.value = $i
+
+	total, int
+		return self.value + wideBase$name
+
+wideStep$name acc;int, int
+	item Wide$name;
+	return acc + item.total
+SRC
+done
+cat >"$dir/package.txt" <<PKG
+package wide$count
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	output bin/wide
+	include $repo_root
+	cxx c++17
+	unity $unity
+PKG
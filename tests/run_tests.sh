@@ -401,6 +401,1082 @@ PKG
     [[ "$output" == *"noop-ok"* ]]
 }
 
+cli_module_cache_reuses_units() {
+    local dir="$work_dir/module-cache"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	println helperMessage
+	return 0
+SRC
+    cat >"$dir/helper.drast" <<SRC
+helperMessage, string
+	return 'cache-one'
+SRC
+    cat >"$dir/package.txt" <<PKG
+package modulecache
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    (cd "$dir" && DRAST_HOME="$repo_root" "$compiler" build >/dev/null 2>"$dir/err1") || return 1
+    local main_cpp="$dir/build/generated/app/main.cpp"
+    local helper_cpp="$dir/build/generated/app/helper.cpp"
+    [[ -f "$main_cpp" && -f "$helper_cpp" ]] || return 1
+    [[ -f "$dir/build/xmake/app/modules/main.module" && -f "$dir/build/xmake/app/modules/helper.module" ]] || return 1
+    # Each record lists the modules its view covers: main names helperMessage, helper names nothing.
+    grep -qx 'dep=helper.drast' "$dir/build/xmake/app/modules/main.module" || return 1
+    if grep -q '^dep=' "$dir/build/xmake/app/modules/helper.module"; then
+        return 1
+    fi
+    # Reuse is keyed on the compiler binary, so units from another `drast` are never mixed in.
+    grep -Eq '^compiler=[0-9a-f]{16}$' "$dir/build/xmake/app/drast.cache" || return 1
+    local main_mtime
+    main_mtime="$(stat_mtime "$main_cpp")"
+    sleep 1
+    touch "$dir/main.drast" "$dir/helper.drast"
+    (cd "$dir" && DRAST_HOME="$repo_root" "$compiler" build >/dev/null 2>"$dir/err2") || return 1
+    [[ "$(stat_mtime "$main_cpp")" == "$main_mtime" ]] || return 1
+    cat >"$dir/helper.drast" <<SRC
+helperMessage, string
+	return 'cache-two'
+SRC
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err3")" || return 1
+    [[ "$output" == *"cache-two"* ]] || return 1
+    [[ "$(stat_mtime "$main_cpp")" == "$main_mtime" ]]
+}
+
+cli_build_state_skips_touched_inputs() {
+    local dir="$work_dir/build-state"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	println 'state-one'
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package buildstate
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    (cd "$dir" && DRAST_HOME="$repo_root" "$compiler" build >/dev/null 2>"$dir/err1") || return 1
+    local binary="$dir/build/bin/app"
+    [[ -x "$binary" && -f "$dir/build/xmake/app/drast.state" ]] || return 1
+    local binary_mtime
+    binary_mtime="$(stat_mtime "$binary")"
+    sleep 1
+    touch "$dir/main.drast" "$dir/package.txt"
+    (cd "$dir" && DRAST_HOME="$repo_root" "$compiler" build >/dev/null 2>"$dir/err2") || return 1
+    [[ "$(stat_mtime "$binary")" == "$binary_mtime" ]] || return 1
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	println 'state-two'
+	return 0
+SRC
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err3")" || return 1
+    [[ "$output" == *"state-two"* ]]
+}
+
+cli_native_backend_builds_incrementally() {
+    local dir="$work_dir/native-backend"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	println helperMessage
+	return 0
+SRC
+    cat >"$dir/helper.drast" <<SRC
+helperMessage, string
+	return 'native-one'
+SRC
+    cat >"$dir/package.txt" <<PKG
+package nativebackend
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+	backend native
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err1")" || return 1
+    [[ "$output" == *"native-one"* ]] || return 1
+    # Build state and the module cache live beside the job database; nothing goes under xmake.
+    [[ -f "$dir/build/native/app/native.db" && -f "$dir/build/native/app/drast.state" ]] || return 1
+    [[ ! -e "$dir/build/xmake/app" ]] || return 1
+    local main_obj
+    main_obj="$(find "$dir/build/native/app/obj" -name 'main-*.o' | head -n 1)"
+    [[ -n "$main_obj" ]] || return 1
+    local main_mtime
+    main_mtime="$(stat_mtime "$main_obj")"
+    sleep 1
+    cat >"$dir/helper.drast" <<SRC
+helperMessage, string
+	return 'native-two'
+SRC
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err2")" || return 1
+    [[ "$output" == *"native-two"* ]] || return 1
+    [[ "$(stat_mtime "$main_obj")" == "$main_mtime" ]]
+}
+
+cli_shared_runtime_support() {
+    local dir="$work_dir/shared-support"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	println 'support-ok'
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package sharedsupport
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err")" || return 1
+    [[ "$output" == *"support-ok"* ]] || return 1
+    local generated="$dir/build/generated/app"
+    [[ -f "$generated/__drt_support.h" && -f "$generated/__drt_support.cpp" ]] || return 1
+    grep -Fq '#include "__drt_support.h"' "$generated/main.cpp" || return 1
+    ! grep -Fq 'namespace __drt' "$generated/main.cpp" || return 1
+    ! grep -Eq '<filesystem>|<random>' "$generated/__drt_support.h"
+}
+
+cli_unity_build_batches_units() {
+    local dir="$work_dir/unity-build"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	total = unityBase + helperValue + otherValue
+	println total
+	return 0
+SRC
+    cat >"$dir/helper.drast" <<SRC
+unityBase int = 40
+
+helperValue, int
+	return unityBase / 20
+SRC
+    cat >"$dir/other.drast" <<SRC
+otherValue, int
+	return unityBase / 40
+SRC
+    cat >"$dir/package.txt" <<PKG
+package unitybuild
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+	unity 2
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err1")" || return 1
+    [[ "$output" == *"43"* ]] || return 1
+    local generated="$dir/build/generated/app"
+    [[ -f "$generated/__unity_0.cpp" && -f "$generated/__unity_1.cpp" && ! -e "$generated/__unity_2.cpp" ]] || return 1
+    cat >"$dir/package.txt" <<PKG
+package unitybuild
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+	unity on
+PKG
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err2")" || return 1
+    [[ "$output" == *"43"* ]] || return 1
+    [[ "$(grep -c 'unityBase = 40' "$generated/__unity_0.cpp")" == "1" ]]
+}
+
+cli_module_headers_share_generics() {
+    local dir="$work_dir/module-headers"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	total = pick 40 + helperValue
+	println total
+	return 0
+SRC
+    cat >"$dir/helper.drast" <<SRC
+pick\`[T] value;T, T
+	return value
+
+helperValue, int
+	return pick 3
+SRC
+    cat >"$dir/package.txt" <<PKG
+package moduleheaders
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err1")" || return 1
+    [[ "$output" == *"43"* ]] || return 1
+    local generated="$dir/build/generated/app"
+    [[ -f "$generated/__drt_program.h" && -f "$generated/helper.drast.h" ]] || return 1
+    grep -Fq 'extern template int pick<int>(' "$generated/__drt_program.h" || return 1
+    grep -Fq 'template int pick<int>(' "$generated/__drt_instances.cpp" || return 1
+    grep -Fq '#include "helper.drast.h"' "$generated/main.cpp" || return 1
+    ! grep -Fq 'return value;' "$generated/main.cpp"
+}
+
+cli_parallel_targets_keep_output_order() {
+    local dir="$work_dir/parallel-targets"
+    mkdir -p "$dir"
+    cat >"$dir/package.txt" <<PKG
+package paralleltargets
+version 0.0.0
+default all
+
+target slow
+	kind command
+	command sleep 1 && echo slow-done && touch slow.stamp
+
+target fast
+	kind command
+	command echo fast-done && touch fast.stamp
+
+target all
+	kind command
+	depends slow fast
+	command test -f slow.stamp && test -f fast.stamp && echo all-done
+PKG
+    local start end output
+    start=$(date +%s)
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" -j 2 build 2>"$dir/err")" || return 1
+    end=$(date +%s)
+    [[ "$output" == $'slow-done\nfast-done\nall-done' ]] || return 1
+    (( end - start < 3 ))
+}
+
+cli_lex_bench_counts_tokens() {
+    local dir="$work_dir/lex-bench"
+    mkdir -p "$dir/nested"
+    cat >"$dir/main.drast" <<SRC
+main, int
+	return 0
+SRC
+    cat >"$dir/nested/deep.drast" <<SRC
+helper value;int, int
+	if value isgt 0
+		return value
+	return 0
+SRC
+    local output
+    output="$(cd "$dir" && "$compiler" lex-bench . 3 2>"$dir/err")" || return 1
+    [[ "$output" == *"files=2 "* && "$output" == *"rounds=3 "* ]] || return 1
+    local single triple
+    single="$(cd "$dir" && "$compiler" lex-bench . 1 | sed -n 's/.*tokens=\([0-9]*\).*/\1/p')"
+    triple="$(sed -n 's/.*tokens=\([0-9]*\).*/\1/p' <<<"$output")"
+    [[ -n "$single" && "$single" -gt 0 && "$triple" -eq $((single * 3)) ]]
+}
+
+cli_last_use_moves_across_branches() {
+    local dir="$work_dir/last-use"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+consume text;string, int
+	return text.length
+
+main, int
+	label = 'branch'
+	total = 0
+	if total == 0
+		total += consume label
+	else
+		total += consume label
+	carried = 'loop'
+	for i in 0 until 3
+		total += consume carried
+	println toString total
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package lastuse
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err")" || return 1
+    [[ "$output" == *"18"* ]] || return 1
+    local cpp="$dir/build/generated/app/main.cpp"
+    [[ "$(grep -Fo 'std::move(label)' "$cpp" | wc -l)" -eq 2 ]] || return 1
+    ! grep -Fq 'std::move(carried)' "$cpp"
+}
+
+cli_last_use_keeps_ref_params_lvalue() {
+    local dir="$work_dir/last-use-ref"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+struct Log
+	lines {string}
+
+impl Log
+	note items;~{string} line;string
+		items += line
+		println 'note ' + toString items.length
+
+fill items;~{string} count;int
+	for i in 0 until count
+		items += 'x'
+	println 'fill ' + toString items.length
+
+main, int
+	items {string};
+	fill items 2
+	lines {string};
+	log Log;
+	log.note lines 'one'
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package lastuseref
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err")" || return 1
+    [[ "$output" == *"fill 2"* && "$output" == *"note 1"* ]] || return 1
+    local cpp="$dir/build/generated/app/main.cpp"
+    ! grep -Fq 'std::move(items)' "$cpp" || return 1
+    ! grep -Fq 'std::move(lines)' "$cpp"
+}
+
+cli_parallel_typecheck_keeps_diagnostic_order() {
+    local dir="$work_dir/parallel-typecheck"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+use helpers
+
+alpha, int
+	first int = 1
+	first int = 2
+	return first
+
+beta, int
+	second int = 1
+	second int = 2
+	return second
+
+main, int
+	return alpha + beta + gamma + delta
+SRC
+    cat >"$dir/helpers.drast" <<SRC
+gamma, int
+	third int = 1
+	third int = 2
+	return third
+
+delta, int
+	fourth int = 1
+	fourth int = 2
+	return fourth
+SRC
+    cat >"$dir/package.txt" <<PKG
+package paralleltc
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    (cd "$dir" && DRAST_HOME="$repo_root" "$compiler" -j 1 build >/dev/null 2>"$dir/err1") && return 1
+    rm -rf "$dir/build"
+    (cd "$dir" && DRAST_HOME="$repo_root" "$compiler" -j 4 build >/dev/null 2>"$dir/err2") && return 1
+    diff "$dir/err1" "$dir/err2" >/dev/null || return 1
+    [[ "$(grep -c 'duplicate local declaration' "$dir/err2")" -eq 4 ]]
+}
+
+cli_constants_fold_into_codegen() {
+    local dir="$work_dir/const-fold"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+LIMIT const int = 40
+VERBOSE const bool = false
+GREETING const string = 'hi'
+
+main, int
+	total = LIMIT + 2 * 1
+	if VERBOSE
+		println 'verbose'
+	elif LIMIT isgt 10
+		total += 0
+	else
+		println 'small'
+	while VERBOSE and true
+		total += 1
+	println GREETING + ' ' + toString total
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package constfold
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err")" || return 1
+    [[ "$output" == *"hi 42"* ]] || return 1
+    local generated=("$dir"/build/generated/app/main.*)
+    grep -Fq 'constexpr int32_t LIMIT = 40;' "${generated[@]}" || return 1
+    grep -Fq '= 42;' "${generated[@]}" || return 1
+    grep -Fq '"hi "' "${generated[@]}" || return 1
+    ! grep -Fq '"verbose"' "${generated[@]}" || return 1
+    ! grep -Fq '"small"' "${generated[@]}" || return 1
+    ! grep -Fq 'while (' "${generated[@]}"
+}
+
+cli_overflow_checked_arithmetic() {
+    local dir="$work_dir/overflow-checked"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	a i32 = 2147483647
+	println toString [a &+ 1]
+	println toString [a |+| 1]
+	total = 0
+	for i in 0 until 10
+		total += i + 1
+	println toString total
+	if total isgt 0
+		println toString [a + total]
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package overflowchecked
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+	overflow checked
+PKG
+    local output
+    if output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err")"; then
+        return 1
+    fi
+    [[ "$output" == *"-2147483648"*"2147483647"*"55"* ]] || return 1
+    grep -Fq 'panic: integer overflow' "$dir/err" || return 1
+    local generated=("$dir"/build/generated/app/main.*)
+    grep -Fq '__drt::add_wrapping(' "${generated[@]}" || return 1
+    grep -Fq '__drt::add_saturating(' "${generated[@]}" || return 1
+    grep -Fq 'total = __drt::add_checked(total, i + 1);' "${generated[@]}"
+}
+
+cli_maybe_niche_layout() {
+    local dir="$work_dir/maybe-niche"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+enum Color
+	Red
+	Green
+	Blue
+
+pick n;int, maybe Color
+	if n isgt 0
+		return Color.Blue
+	return nil
+
+main, int
+	first = pick 1
+	second = pick 0
+	if first isne nil and second == nil
+		println 'niche enum'
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package maybeniche
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run)" || return 1
+    [[ "$output" == *"niche enum"* ]] || return 1
+    local generated=("$dir"/build/generated/app/main.* "$dir"/build/generated/app/__drt_program.h)
+    grep -Fq '__drt::maybe<Color>' "${generated[@]}" || return 1
+    grep -Fq 'drast_niche_value(Color)' "${generated[@]}" || return 1
+    cat >"$dir/sizes.cpp" <<CPP
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include "__drt_program.h"
+static_assert(sizeof(__drt::maybe<Color>) == sizeof(Color), "enum none uses a spare value");
+static_assert(sizeof(__drt::maybe<int&>) == sizeof(int*), "reference none is a null pointer");
+static_assert(sizeof(__drt::maybe<int*>) == sizeof(int*), "raw pointer none is a null pointer");
+static_assert(sizeof(__drt::heap_maybe<std::shared_ptr<int>>) == sizeof(std::shared_ptr<int>), "heap none is a null pointer");
+static_assert(std::is_same_v<__drt::maybe<std::shared_ptr<int>>, std::optional<std::shared_ptr<int>>>, "a C++ shared_ptr may hold null");
+static_assert(std::is_same_v<__drt::maybe<std::function<void()>>, std::optional<std::function<void()>>>, "an empty std::function is a value");
+static_assert(sizeof(__drt::maybe<int>) == sizeof(std::optional<int>), "plain values keep std::optional");
+CPP
+    "${CXX:-c++}" -std=c++17 -fsyntax-only -I "$dir/build/generated/app" "$dir/sizes.cpp"
+}
+
+cli_map_single_probe() {
+    local dir="$work_dir/map-single-probe"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+countWords words;{string}, int
+	counts map\`[string int];
+	for word in words
+		if counts.contains word
+			current = counts.get word 0
+			counts.set word current + 1
+		else
+			counts.set word 1
+	seen map\`[string int];
+	for word in words
+		seen.set word [seen.get word 0] + 1
+	total = 0
+	for word in words
+		total += [counts.get word 0] * [seen.get word 0]
+	return total
+
+main, int
+	words = {s'one' s'two' s'one' s'three' s'one'}
+	println toString [countWords words]
+	odds {int};
+	odds += 1
+	odds += 3
+	lists map\`[string {int}];
+	lists.set s'odd' odds
+	found = lists.getRef s'odd'
+	if found isne nil
+		println toString found.value.length
+	missing = lists.getRef s'even'
+	if missing == nil
+		println 'no evens'
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package mapprobe
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run)" || return 1
+    [[ "$output" == $'29\n2\nno evens' ]] || return 1
+    local generated=("$dir"/build/generated/app/main.*)
+    grep -Fq 'if (auto* _found0 = __drt::map_find(counts, word)) {' "${generated[@]}" || return 1
+    grep -Fq '(*_found0) = current + 1;' "${generated[@]}" || return 1
+    grep -Fq 'auto& _slot1 = __drt::map_slot(seen, word, 0);' "${generated[@]}" || return 1
+    grep -Fq '__drt::map_ref(lists, ' "${generated[@]}" || return 1
+    ! grep -Fq '__drt::contains(counts' "${generated[@]}"
+}
+
+cli_flat_map_default() {
+    local dir="$work_dir/flat-map-default"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	counts map\`[string int];
+	legacy node_map\`[string int];
+	words = {s'b' s'a' s'c' s'a' s'd'}
+	for word in words
+		counts.set word [counts.get word 0] + 1
+		legacy.set word [legacy.get word 0] + 1
+	counts.remove s'a'
+	legacy.remove s'a'
+	order string;
+	for key in counts.keys
+		order += key
+	println order
+	println toString counts.length
+	println toString legacy.length
+	ids map\`[int int];
+	for i in 0 until 1000
+		ids.set i i * 2
+	for i in 0 until 1000 step 2
+		ids.remove i
+	println toString ids.length
+	println toString [ids.get 999 0]
+	println toString [ids.get 2 0]
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package flatmap
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run)" || return 1
+    [[ "$output" == $'bcd\n3\n3\n500\n1998\n0' ]] || return 1
+    local generated=("$dir"/build/generated/app/main.*)
+    grep -Fq '__drt::flat_map<std::string, int32_t> counts;' "${generated[@]}" || return 1
+    grep -Fq 'std::unordered_map<std::string, int32_t> legacy;' "${generated[@]}"
+}
+
+cli_set_collection() {
+    local dir="$work_dir/set-collection"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	seen set\`[string];
+	words = {s'b' s'a' s'c' s'a' s'd' s'b'}
+	fresh = 0
+	for word in words
+		if seen.insert word
+			fresh += 1
+	println toString fresh
+	seen.remove s'c'
+	println toString seen.length
+	vowels = set\`{s'a' s'e' s'i'}
+	both = seen.intersection vowels
+	either = seen.union vowels
+	println toString both.length
+	println toString either.length
+	if both.contains s'a' and not both.contains s'b'
+		println s'ok'
+	primes set\`[int] = {2 3 5 7 3}
+	total = 0
+	for p in primes
+		total += p
+	println toString total
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package sets
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run)" || return 1
+    [[ "$output" == $'4\n3\n1\n5\nok\n17' ]] || return 1
+    local generated=("$dir"/build/generated/app/main.*)
+    grep -Fq '__drt::flat_set<std::string> seen;' "${generated[@]}" || return 1
+    grep -Fq '__drt::set_intersection(seen, vowels)' "${generated[@]}"
+}
+
+cli_match_switch_lowering() {
+    local dir="$work_dir/match-switch"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+enum Shape
+	Circle radius;int
+	Square side;int
+
+enum Color
+	Red
+	Green
+	Blue
+
+area shape;~Shape, int
+	match shape
+		Shape.Circle radius
+			return radius * radius * 3
+		Shape.Square side
+			return side * side
+
+colorCode color;Color, int
+	match color
+		.Red
+			return 1
+		.Green
+			return 2
+		.Blue
+			return 3
+
+digitName n;int, string
+	match n
+		0
+			return s'zero'
+		1
+			return s'one'
+		default
+			return s'many'
+
+letterKind code;int, string
+	match code
+		65
+			return s'first'
+		[charCode 'A']
+			return s'second'
+		default
+			return s'other'
+
+countUntilStop values;{int}, int
+	total = 0
+	for v in values
+		match v
+			0
+				break
+			default
+				total += v
+	return total
+
+main, int
+	shapes = {Shape.Circle[2] Shape.Square[3]}
+	total = 0
+	for shape in shapes
+		total += area shape
+	println toString total
+	println toString [colorCode Color.Blue]
+	println [digitName 1]
+	println [digitName 5]
+	println toString [countUntilStop {3 4 0 5}]
+	println [letterKind 65]
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package matchswitch
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run)" || return 1
+    [[ "$output" == $'21\n3\none\nmany\n7\nfirst' ]] || return 1
+    local generated=("$dir"/build/generated/app/main.*)
+    grep -Fq 'switch (_match.data.index()) {' "${generated[@]}" || return 1
+    grep -Fq 'switch (_match) {' "${generated[@]}" || return 1
+    grep -Fq '__builtin_unreachable();' "${generated[@]}" || return 1
+    # Two arms fold to 65, which would be a duplicate case, so that match stays an if chain.
+    grep -Fq 'if (_match == 65) {' "${generated[@]}" || return 1
+    # The `break` leaves the loop, so that match must not become a switch.
+    grep -Fq 'if (_match == 0) {' "${generated[@]}"
+}
+
+cli_compact_enum() {
+    local dir="$work_dir/compact-enum"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+enum Expr compact
+	Number value;int
+	Name text;string
+	Add left;Expr right;Expr
+	Empty
+
+eval expr;~Expr, int
+	match expr
+		Expr.Number value
+			return value
+		Expr.Name text
+			return 10
+		Expr.Add left right
+			return [eval left] + [eval right]
+		Expr.Empty
+			return 0
+
+main, int
+	kept = Expr.Add[Expr.Number[2] Expr.Name[s'ab']]
+	total = 0
+	for i in 0 until 100
+		tree = Expr.Add[Expr.Number[i] Expr.Add[kept Expr.Empty[]]]
+		total += eval tree
+	println toString total
+	println toString [eval kept]
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package compactenum
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run)" || return 1
+    [[ "$output" == $'6150\n12' ]] || return 1
+    local generated=("$dir"/build/generated/app/main.*)
+    grep -Fq 'enum class Tag : std::uint8_t {' "${generated[@]}" || return 1
+    grep -Fq '__drt::region_build _build;' "${generated[@]}" || return 1
+    grep -Fq 'switch (_match.tag) {' "${generated[@]}" || return 1
+    ! grep -Fq 'std::monostate' "${generated[@]}"
+}
+
+cli_string_builder() {
+    local dir="$work_dir/string-builder"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+label name;string index;int, string
+	return 'item ' + name + c'#' + toString index
+
+main, int
+	names {string};
+	names += 'a'
+	names += 'bb'
+	log string;
+	for i in 0 until 3
+		name = names{i % 2}
+		log += s'[' + [label name i] + '] '
+	tail = 'x'
+	tail += tail + '!'
+	b StringBuilder;
+	b.reserve 64
+	b.append 'head:'
+	b.append c' '
+	b.append [log + s'|']
+	text = b.toString
+	println text
+	println toString b.text.length
+	println toString text.length
+	println tail
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package stringbuilder
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run)" || return 1
+    [[ "$output" == $'head: [item a#0] [item bb#1] [item a#2] |\n0\n41\nxx!' ]] || return 1
+    local generated=("$dir"/build/generated/app/main.*)
+    grep -Fq '__drt::concat("item ", name, ' "${generated[@]}" || return 1
+    grep -Fq '__drt::concat_append(log, ' "${generated[@]}" || return 1
+    grep -Fq '__drt::concat_append(b.text, ' "${generated[@]}" || return 1
+    grep -Fq 'tail += tail + "!";' "${generated[@]}"
+}
+
+cli_concat_append_in_emitters() {
+    local dir="$work_dir/concat-append-emitters"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+struct Writer
+	out string
+
+impl Writer
+	init
+		self.out = ''
+
+	setting name;string value;int
+		self.out += '    set(' + name + ', ' + toString value + ')' + c'\n'
+
+emitList out;~string items;{string}
+	for item in items
+		out += c'#' + item + '\n'
+
+main, int
+	w Writer;
+	w.setting 'alpha' 1
+	w.setting 'beta' 22
+	items {string};
+	items += 'x'
+	items += 'yz'
+	listing string;
+	emitList listing items
+	print w.out
+	print listing
+	return 0
+SRC
+    cat >"$dir/package.txt" <<PKG
+package concatappend
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run)" || return 1
+    [[ "$output" == $'    set(alpha, 1)\n    set(beta, 22)\n#x\n#yz' ]] || return 1
+    local generated=("$dir"/build/generated/app/main.*)
+    # Both the field and the ~string parameter get the pre-sized append, not a temporary.
+    grep -Eq '__drt::concat_append\((this->)?out, "    set\(", name, ' "${generated[@]}" || return 1
+    grep -Fq "__drt::concat_append(out, '#', item, " "${generated[@]}"
+}
+
+cli_parallel_codegen_matches_serial() {
+    local dir="$work_dir/parallel-codegen"
+    mkdir -p "$dir"
+    cat >"$dir/main.drast" <<SRC
+use drast
+
+main, int
+	message = partOne + partTwo
+	println message
+	return 0
+SRC
+    cat >"$dir/one.drast" <<SRC
+partOne, string
+	return 'parallel-'
+SRC
+    cat >"$dir/two.drast" <<SRC
+partTwo, string
+	return 'ok'
+SRC
+    cat >"$dir/package.txt" <<PKG
+package parallel
+version 0.0.0
+default app
+
+target app
+	kind binary
+	entry main.drast
+	include $repo_root
+	cxx c++17
+PKG
+    (cd "$dir" && DRAST_HOME="$repo_root" "$compiler" -j 1 build >/dev/null 2>"$dir/err1") || return 1
+    cp -R "$dir/build/generated/app" "$dir/serial"
+    rm -rf "$dir/build"
+    (cd "$dir" && DRAST_HOME="$repo_root" "$compiler" -j 4 build >/dev/null 2>"$dir/err2") || return 1
+    diff -r "$dir/serial" "$dir/build/generated/app" >/dev/null || return 1
+    local output
+    output="$(cd "$dir" && DRAST_HOME="$repo_root" "$compiler" run 2>"$dir/err3")" || return 1
+    [[ "$output" == *"parallel-ok"* ]]
+}
+
+cli_wide_program_scales_linearly() {
+    # Builds 100 and 400 generated modules. A quadratic pass would make the larger package
+    # cost about four times as much per module; fixed startup costs push the ratio the
+    # other way, so a linear build stays well under the 2.5x bound.
+    local count elapsed per_module first=""
+    for count in 100 400; do
+        local dir="$work_dir/wide-$count"
+        "$repo_root/scripts/gen_wide_package.sh" "$dir" "$count" || return 1
+        local start end output
+        start=$(date +%s%N)
+        (cd "$dir" && DRAST_HOME="$repo_root" "$compiler" build >/dev/null 2>"$dir/err") || return 1
+        end=$(date +%s%N)
+        output="$("$(find "$dir/build" -type f -name wide -perm -u+x | head -n 1)")" || return 1
+        [[ "$output" == "$((count * (count - 1)))" ]] || return 1
+        elapsed=$((end - start))
+        per_module=$((elapsed / count))
+        if [[ -z "$first" ]]; then
+            first="$per_module"
+        fi
+    done
+    (( per_module * 2 <= first * 5 ))
+}
+
 cli_legacy_build_paths_remap() {
     local dir="$work_dir/legacy-layout"
     mkdir -p "$dir"
@@ -667,6 +1743,29 @@ run_cli_case "generated-readonly-regenerates" cli_generated_readonly_regenerates
 run_cli_case "default-build-layout" cli_default_build_layout
 run_cli_case "bare-no-prelude" cli_bare_no_prelude
 run_cli_case "noop-build-is-stable" cli_noop_build_is_stable
+run_cli_case "module-cache-reuses-units" cli_module_cache_reuses_units
+run_cli_case "build-state-skips-touched-inputs" cli_build_state_skips_touched_inputs
+run_cli_case "native-backend-builds-incrementally" cli_native_backend_builds_incrementally
+run_cli_case "shared-runtime-support" cli_shared_runtime_support
+run_cli_case "unity-build-batches-units" cli_unity_build_batches_units
+run_cli_case "module-headers-share-generics" cli_module_headers_share_generics
+run_cli_case "parallel-targets-keep-output-order" cli_parallel_targets_keep_output_order
+run_cli_case "lex-bench-counts-tokens" cli_lex_bench_counts_tokens
+run_cli_case "last-use-moves-across-branches" cli_last_use_moves_across_branches
+run_cli_case "last-use-keeps-ref-params-lvalue" cli_last_use_keeps_ref_params_lvalue
+run_cli_case "parallel-typecheck-keeps-diagnostic-order" cli_parallel_typecheck_keeps_diagnostic_order
+run_cli_case "constants-fold-into-codegen" cli_constants_fold_into_codegen
+run_cli_case "overflow-checked-arithmetic" cli_overflow_checked_arithmetic
+run_cli_case "maybe-niche-layout" cli_maybe_niche_layout
+run_cli_case "map-single-probe" cli_map_single_probe
+run_cli_case "flat-map-default" cli_flat_map_default
+run_cli_case "set-collection" cli_set_collection
+run_cli_case "match-switch-lowering" cli_match_switch_lowering
+run_cli_case "compact-enum" cli_compact_enum
+run_cli_case "string-builder" cli_string_builder
+run_cli_case "concat-append-in-emitters" cli_concat_append_in_emitters
+run_cli_case "parallel-codegen-matches-serial" cli_parallel_codegen_matches_serial
+run_cli_case "wide-program-scales-linearly" cli_wide_program_scales_linearly
 run_cli_case "legacy-build-paths-remap" cli_legacy_build_paths_remap
 run_cli_case "explicit-paths-remap" cli_explicit_paths_remap
 run_cli_case "absolute-paths-remap" cli_absolute_paths_remap